@@ -0,0 +1,216 @@
+// gmath anim.h
+// Date: 19 10 2026
+// Author: arinaivanova
+// URL: https://github.com/arinaivanova/gmath
+// Commentary: Keyframe track sampling over Vec3 and Quat keys.
+
+#ifndef GMATH_ANIM_H_
+#define GMATH_ANIM_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include "quat.h"
+#include "util.h"
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace gmath
+{
+	// rotation compressed to 48 bits: the three smallest components at 15 bits each, and the index of
+	// the largest in the top bits of a and b. the largest is recovered from the unit length.
+	struct QuatKey
+	{
+		uint16_t a, b, c;
+	};
+
+	inline QuatKey pack(const Quat& rotation)
+	{
+		Quat q = normalize(rotation);
+		uint big = 0;
+		for (uint i = 4; --i;) big = fabsf(q[i]) > fabsf(q[big]) ? i : big;
+		if (q[big] < 0.f) q = -q;
+
+		uint16_t u[3];
+		for (uint i = 0, j = 0; i < 4; ++i)
+		{
+			if (i == big) continue;
+			// smallest components lie in [-1/sqrt(2), 1/sqrt(2)]
+			const float c = clamp(q[i]*1.41421356f, 1.f);
+			u[j++] = uint16_t((c*0.5f + 0.5f)*32767.f + 0.5f);
+		}
+		return { uint16_t(u[0] | (big & 1) << 15), uint16_t(u[1] | (big >> 1) << 15), u[2] };
+	}
+
+	inline Quat unpack(const QuatKey& k)
+	{
+		const uint big = (k.a >> 15) | (k.b >> 15) << 1;
+		const uint16_t u[3] { uint16_t(k.a & 0x7fff), uint16_t(k.b & 0x7fff), k.c };
+		Quat q;
+		float sum = 0.f;
+		for (uint i = 0, j = 0; i < 4; ++i)
+		{
+			if (i == big) continue;
+			const float c = (u[j++]*(1.f/32767.f)*2.f - 1.f)*0.70710678f;
+			q[i] = c, sum += c*c;
+		}
+		q[big] = sqrtf(sum < 1.f ? 1.f - sum : 0.f);
+		return q;
+	}
+
+	// keyframes of a single channel as structure of arrays. times are ascending, values[i] is the key at
+	// times[i]. the arrays are not owned, e.g. they may point into an Archive.
+	template <class T> struct Track
+	{
+		const float* times;
+		const T* values;
+		uint count;
+	};
+	typedef Track<Vec3>    Vec3Track;
+	typedef Track<Quat>    QuatTrack;
+	typedef Track<QuatKey> QuatKeyTrack;
+
+	// value type a track of keys T samples to
+	template <class T> struct Sampled { typedef T type; };
+	template <> struct Sampled<QuatKey> { typedef Quat type; };
+
+	inline const Vec3& decode(const Vec3& v) { return v; }
+	inline const Quat& decode(const Quat& q) { return q; }
+	inline Quat decode(const QuatKey& k) { return unpack(k); }
+
+	inline Vec3 blend(const Vec3& v0, const Vec3& v1, float t) { return lerp(v0, v1, t); }
+	inline Quat blend(const Quat& q0, const Quat& q1, float t) { return nlerp(q0, q1, t); }
+
+	// returns index k of the key at or before time t and sets weight to the position of t between keys k
+	// and k+1. cursor is the k of the previous call on this track: playback that moves forward by
+	// about one key per call is O(1), jumps fall back to binary search.
+	template <class T> uint seek(const Track<T>& track, float t, uint& cursor, float& weight)
+	{
+		assert(track.count);
+		const float* times = track.times;
+		const uint n = track.count;
+		uint k = cursor < n ? cursor : 0;
+		if (t >= times[k])
+		{
+			for (uint step = 4; step-- && k + 1 < n && t >= times[k+1]; ++k);
+			if (k + 1 < n && t >= times[k+1])
+				k = uint(std::upper_bound(times + k + 1, times + n, t) - times) - 1;
+		}
+		else
+		{
+			k = uint(std::upper_bound(times, times + k, t) - times);
+			k = k ? k - 1 : 0;
+		}
+		cursor = k;
+
+		if (k + 1 >= n) weight = 0.f;
+		else
+		{
+			const float w = (t - times[k]) / (times[k+1] - times[k]);
+			weight = w < 0.f ? 0.f : w > 1.f ? 1.f : w;
+		}
+		return k;
+	}
+
+	// samples track at time t, clamping to the first and last keys
+	template <class T> typename Sampled<T>::type sample(const Track<T>& track, float t, uint& cursor)
+	{
+		float w;
+		const uint k = seek(track, t, cursor, w);
+		if (k + 1 >= track.count) return decode(track.values[k]);
+		return blend(decode(track.values[k]), decode(track.values[k+1]), w);
+	}
+
+	namespace base
+	{
+		constexpr uint SAMPLE_CHUNK { 64 };
+
+		// blends chunks of keys laid out per component, four tracks per SSE vector with a scalar tail. the
+		// operations are those of lerp() and nlerp() in the same order, so results equal sample() per track
+		// as long as the compiler does not contract either into fused multiply-adds.
+		inline void blend(const float (*a)[SAMPLE_CHUNK], const float (*b)[SAMPLE_CHUNK], const float* w, uint n, Vec3* out)
+		{
+			float r[3][SAMPLE_CHUNK];
+			uint i = 0;
+#if defined(__SSE__)
+			for (; i + 4 <= n; i += 4)
+			{
+				const __m128 t = _mm_loadu_ps(w + i), t0 = _mm_sub_ps(_mm_set1_ps(1.f), t);
+				for (uint c = 3; c--;)
+					_mm_storeu_ps(r[c] + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a[c] + i), t0), _mm_mul_ps(_mm_loadu_ps(b[c] + i), t)));
+			}
+#endif
+			for (; i < n; ++i)
+				for (uint c = 3; c--;) r[c][i] = a[c][i]*(1.f - w[i]) + b[c][i]*w[i];
+			for (i = 0; i < n; ++i) out[i] = { r[0][i], r[1][i], r[2][i] };
+		}
+
+		inline void blend(const float (*a)[SAMPLE_CHUNK], const float (*b)[SAMPLE_CHUNK], const float* w, uint n, Quat* out)
+		{
+			uint i = 0;
+#if defined(__SSE__)
+			const __m128 one = _mm_set1_ps(1.f), sign = _mm_set1_ps(-0.f), zero = _mm_setzero_ps();
+			for (; i + 4 <= n; i += 4)
+			{
+				const __m128 t = _mm_loadu_ps(w + i);
+				__m128 a4[4], b4[4], r[4];
+				for (uint c = 4; c--;) a4[c] = _mm_loadu_ps(a[c] + i), b4[c] = _mm_loadu_ps(b[c] + i);
+				__m128 d = _mm_mul_ps(a4[0], b4[0]);
+				for (uint c = 1; c < 4; ++c) d = _mm_add_ps(d, _mm_mul_ps(a4[c], b4[c]));
+				// shorter arc: blend towards -b when the keys are in opposite hemispheres
+				const __m128 s = _mm_xor_ps(t, _mm_and_ps(_mm_cmplt_ps(d, zero), sign));
+				const __m128 t0 = _mm_sub_ps(one, t);
+				for (uint c = 4; c--;) r[c] = _mm_add_ps(_mm_mul_ps(a4[c], t0), _mm_mul_ps(b4[c], s));
+				// summed in the order of dot(), zero where normalize() returns a zero quaternion
+				__m128 m = _mm_mul_ps(r[0], r[0]);
+				for (uint c = 1; c < 4; ++c) m = _mm_add_ps(m, _mm_mul_ps(r[c], r[c]));
+				m = _mm_sqrt_ps(m);
+				const __m128 inv = _mm_and_ps(_mm_div_ps(one, m), _mm_cmpneq_ps(m, zero));
+				for (uint c = 4; c--;) r[c] = _mm_mul_ps(r[c], inv);
+				// components per track to tracks per component
+				_MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+				for (uint j = 4; j--;) _mm_storeu_ps(&out[i + j].w, r[j]);
+			}
+#endif
+			for (; i < n; ++i)
+			{
+				const Quat q0 { a[0][i], a[1][i], a[2][i], a[3][i] };
+				const Quat q1 { b[0][i], b[1][i], b[2][i], b[3][i] };
+				out[i] = nlerp(q0, q1, w[i]);
+			}
+		}
+	} // namespace base
+
+	// samples n tracks, track i at time t[i] with cursor cursors[i], into out[i]. keys are located and
+	// decoded per track, then blended a chunk of tracks at a time, with SSE where available.
+	template <class T> void sample(const Track<T>* tracks, const float* t, uint* cursors, uint n, typename Sampled<T>::type* out)
+	{
+		typedef typename Sampled<T>::type V;
+		constexpr uint COMPONENTS = sizeof(V)/sizeof(float);
+		constexpr uint CHUNK = base::SAMPLE_CHUNK;
+
+		for (uint first = 0; first < n; first += CHUNK)
+		{
+			const uint m = n - first < CHUNK ? n - first : CHUNK;
+			float a[COMPONENTS][CHUNK], b[COMPONENTS][CHUNK], w[CHUNK];
+			uint last[CHUNK], clamped = 0;
+			for (uint i = 0; i < m; ++i)
+			{
+				const Track<T>& track = tracks[first + i];
+				const uint k = seek(track, t[first + i], cursors[first + i], w[i]);
+				if (k + 1 >= track.count) last[clamped++] = i;
+				const V v0 = decode(track.values[k]);
+				const V v1 = decode(track.values[k + 1 < track.count ? k + 1 : k]);
+				for (uint c = COMPONENTS; c--;) a[c][i] = v0[c], b[c][i] = v1[c];
+			}
+			base::blend(a, b, w, m, out + first);
+			// like sample(), tracks past their last key return it unblended
+			for (uint j = clamped; j--;)
+			{
+				const uint i = last[j];
+				for (uint c = COMPONENTS; c--;) out[first + i][c] = a[c][i];
+			}
+		}
+	}
+} // namespace gmath
+#endif
@@ -0,0 +1,305 @@
+// gmath archive.h
+// Date: 19 10 2026
+// Author: arinaivanova
+// URL: https://github.com/arinaivanova/gmath
+// Commentary: Binary container for arrays of gmath types, written in a stream and read in place from a memory map.
+
+#ifndef GMATH_ARCHIVE_H_
+#define GMATH_ARCHIVE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "quat.h"
+#include "mat4.h"
+
+// File layout, all offsets in bytes from the start of the file:
+//   ArchiveHeader                       at 0
+//   array data, each aligned to ALIGN   from ALIGN
+//   ArchiveEntry[count]                 at ArchiveHeader::dir
+// The directory is written last so that arrays can be streamed without knowing their sizes up front.
+
+namespace gmath
+{
+	// type tags stored per array. the size of the type is stored alongside and checked on load.
+	template <class T> struct ArchiveType;
+	template <> struct ArchiveType<float> { static constexpr uint32_t id { 1 }; };
+	template <> struct ArchiveType<Vec2>  { static constexpr uint32_t id { 2 }; };
+	template <> struct ArchiveType<Vec3>  { static constexpr uint32_t id { 3 }; };
+	template <> struct ArchiveType<Vec4>  { static constexpr uint32_t id { 4 }; };
+	template <> struct ArchiveType<Quat>  { static constexpr uint32_t id { 5 }; };
+	template <> struct ArchiveType<Mat4>  { static constexpr uint32_t id { 6 }; };
+
+	struct ArchiveHeader
+	{
+		static constexpr uint32_t MAGIC   { 0x48544d47 }; // "GMTH"
+		static constexpr uint32_t VERSION { 1 };
+		static constexpr uint32_t ENDIAN  { 0x01020304 };
+		static constexpr uint32_t ALIGN   { 64 };
+
+		uint32_t magic, version, endian, align;
+		uint32_t floatSize, count;  // sizeof(float) of the writer, number of arrays
+		uint64_t dir, dirSum;       // offset and checksum of the directory
+		uint8_t  pad[24];
+	};
+	static_assert(sizeof(ArchiveHeader) == ArchiveHeader::ALIGN, "archive header must fill one alignment unit");
+
+	struct ArchiveEntry
+	{
+		uint32_t type, stride;      // ArchiveType id, sizeof the type
+		uint64_t count, offset;     // number of elements, offset of the first
+		uint64_t sum;               // checksum of the data
+	};
+
+	// 64-bit hash of 8-byte words: each word is xored in and multiplied by the FNV prime, then the high
+	// half is folded into the low half so a change in the top bits of a word reaches the next multiply.
+	// bytes are carried over between update() calls so the result does not depend on how the data was split.
+	struct Checksum
+	{
+		Checksum() : hash_{ 14695981039346656037ull }, tail_{}, n_{} {}
+
+		void update(const void* data, size_t size)
+		{
+			const unsigned char* b = static_cast<const unsigned char*>(data);
+			for (; size && n_; --size) feed(*b++);
+			for (; size >= 8; size -= 8, b += 8)
+			{
+				uint64_t w;
+				memcpy(&w, b, 8);
+				mix(w);
+			}
+			for (; size; --size) feed(*b++);
+		}
+
+		uint64_t value() const
+		{
+			Checksum sum { *this };
+			if (sum.n_) sum.mix(sum.tail_);
+			return sum.hash_;
+		}
+
+	private:
+		void feed(unsigned char c)
+		{
+			tail_ |= uint64_t(c) << 8*n_;
+			if (++n_ == 8) mix(tail_), tail_ = 0, n_ = 0;
+		}
+		void mix(uint64_t w)
+		{
+			hash_ = (hash_ ^ w) * 0x100000001b3ull;
+			hash_ ^= hash_ >> 32;
+		}
+
+		uint64_t hash_, tail_;
+		uint n_;
+	};
+
+	// read-only view of count elements
+	template <class T> struct Span
+	{
+		Span() : data_{}, size_{} {}
+		Span(const T* data, uint64_t size) : data_{ data }, size_{ size } {}
+
+		const T& operator [] (uint64_t i) const { assert(i < size_); return data_[i]; }
+
+		const T* data()  const { return data_; }
+		uint64_t size()  const { return size_; }
+		bool     empty() const { return !size_; }
+		const T* begin() const { return data_; }
+		const T* end()   const { return data_ + size_; }
+
+	private:
+		const T* data_;
+		uint64_t size_;
+	};
+
+	// Writes arrays one after another. An array is either written whole with write() or streamed in
+	// pieces between begin() and end(). close() writes the directory and patches the header.
+	// after a failed write every further call fails, and close() returns false.
+	struct ArchiveWriter
+	{
+		ArchiveWriter() : file_{}, pos_{}, open_{}, failed_{} {}
+		~ArchiveWriter() { close(); }
+		ArchiveWriter(const ArchiveWriter&) = delete;
+		ArchiveWriter& operator = (const ArchiveWriter&) = delete;
+
+		bool open(const char* path)
+		{
+			close();
+			entries_.clear();
+			failed_ = false;
+			file_ = fopen(path, "wb");
+			if (!file_) return false;
+			const ArchiveHeader h {};
+			pos_ = 0;
+			return put(&h, sizeof h);
+		}
+
+		template <class T> bool begin()
+		{
+			assert(file_ && !open_);
+			if (failed_ || !pad()) return false;
+			ArchiveEntry e {};
+			e.type = ArchiveType<T>::id, e.stride = sizeof(T), e.offset = pos_;
+			entries_.push_back(e);
+			sum_ = Checksum();
+			open_ = true;
+			return true;
+		}
+
+		template <class T> bool append(const T* data, uint64_t count)
+		{
+			assert(open_ && entries_.back().type == ArchiveType<T>::id);
+			if (failed_) return false;
+			sum_.update(data, count*sizeof(T));
+			entries_.back().count += count;
+			return put(data, count*sizeof(T));
+		}
+
+		void end()
+		{
+			assert(open_);
+			entries_.back().sum = sum_.value();
+			open_ = false;
+		}
+
+		// writes count elements as one array. returns the index of the array, or -1 on failure.
+		template <class T> int write(const T* data, uint64_t count)
+		{
+			if (!begin<T>()) return -1;
+			const bool ok = append(data, count);
+			end();
+			return ok ? int(entries_.size()) - 1 : -1;
+		}
+
+		bool close()
+		{
+			if (!file_) return true;
+			if (open_) end();
+			ArchiveHeader h {};
+			h.magic = ArchiveHeader::MAGIC, h.version = ArchiveHeader::VERSION;
+			h.endian = ArchiveHeader::ENDIAN, h.align = ArchiveHeader::ALIGN;
+			h.floatSize = sizeof(float), h.count = entries_.size();
+
+			Checksum dirSum;
+			dirSum.update(entries_.data(), entries_.size()*sizeof(ArchiveEntry));
+			h.dirSum = dirSum.value();
+
+			bool ok = !failed_ && pad();
+			h.dir = pos_;
+			ok = ok && put(entries_.data(), entries_.size()*sizeof(ArchiveEntry));
+			ok = ok && !fseek(file_, 0, SEEK_SET) && fwrite(&h, sizeof h, 1, file_) == 1;
+			ok = !fclose(file_) && ok;
+			file_ = nullptr;
+			return ok;
+		}
+
+	private:
+		bool put(const void* data, size_t size)
+		{
+			pos_ += size;
+			if (size && fwrite(data, size, 1, file_) != 1) failed_ = true;
+			return !failed_;
+		}
+
+		bool pad()
+		{
+			static const unsigned char zero[ArchiveHeader::ALIGN] {};
+			return put(zero, (ArchiveHeader::ALIGN - pos_ % ArchiveHeader::ALIGN) % ArchiveHeader::ALIGN);
+		}
+
+		FILE* file_;
+		uint64_t pos_;
+		bool open_, failed_;
+		Checksum sum_;
+		std::vector<ArchiveEntry> entries_;
+	};
+
+	// Maps an archive read-only. open() validates the header and directory only; array data is read
+	// lazily through page faults. verify() checks the data of an array against its checksum.
+	struct Archive
+	{
+		Archive() : base_{}, size_{} {}
+		~Archive() { close(); }
+		Archive(const Archive&) = delete;
+		Archive& operator = (const Archive&) = delete;
+
+		bool open(const char* path)
+		{
+			close();
+			const int fd = ::open(path, O_RDONLY);
+			if (fd < 0) return false;
+			struct stat st;
+			if (fstat(fd, &st) || uint64_t(st.st_size) < sizeof(ArchiveHeader)) { ::close(fd); return false; }
+			size_ = st.st_size;
+			void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+			if (map == MAP_FAILED) { size_ = 0; return false; }
+			base_ = static_cast<const unsigned char*>(map);
+			if (!valid()) { close(); return false; }
+			return true;
+		}
+
+		void close()
+		{
+			if (base_) munmap(const_cast<unsigned char*>(base_), size_);
+			base_ = nullptr, size_ = 0;
+		}
+
+		uint count() const { return base_ ? header().count : 0; }
+		const ArchiveEntry& entry(uint i) const { assert(i < count()); return entries()[i]; }
+
+		// returns array i viewed as T, or an empty span if it holds a different type
+		template <class T> Span<T> array(uint i) const
+		{
+			const ArchiveEntry& e = entry(i);
+			if (e.type != ArchiveType<T>::id || e.stride != sizeof(T)) return {};
+			return { reinterpret_cast<const T*>(base_ + e.offset), e.count };
+		}
+
+		bool verify(uint i) const
+		{
+			const ArchiveEntry& e = entry(i);
+			Checksum sum;
+			sum.update(base_ + e.offset, e.count*e.stride);
+			return sum.value() == e.sum;
+		}
+
+	private:
+		const ArchiveHeader& header() const { return *reinterpret_cast<const ArchiveHeader*>(base_); }
+		const ArchiveEntry* entries() const { return reinterpret_cast<const ArchiveEntry*>(base_ + header().dir); }
+
+		bool valid() const
+		{
+			const ArchiveHeader& h = header();
+			if (h.magic != ArchiveHeader::MAGIC || h.version != ArchiveHeader::VERSION
+				|| h.endian != ArchiveHeader::ENDIAN || h.align != ArchiveHeader::ALIGN
+				|| h.floatSize != sizeof(float))
+				return false;
+			if (h.dir % ArchiveHeader::ALIGN || h.dir > size_ || (size_ - h.dir)/sizeof(ArchiveEntry) < h.count)
+				return false;
+
+			Checksum sum;
+			sum.update(entries(), h.count*sizeof(ArchiveEntry));
+			if (sum.value() != h.dirSum) return false;
+
+			for (uint i = h.count; i--;)
+			{
+				const ArchiveEntry& e = entries()[i];
+				if (e.offset % ArchiveHeader::ALIGN || e.offset > h.dir || !e.stride
+					|| (h.dir - e.offset)/e.stride < e.count)
+					return false;
+			}
+			return true;
+		}
+
+		const unsigned char* base_;
+		uint64_t size_;
+	};
+} // namespace gmath
+#endif
@@ -0,0 +1,203 @@
+// gmath curve.h
+// Date: 19 10 2026
+// Author: arinaivanova
+// URL: https://github.com/arinaivanova/gmath
+// Commentary: Morton and Hilbert space-filling curve keys, and reordering of arrays along them.
+
+#ifndef GMATH_CURVE_H_
+#define GMATH_CURVE_H_
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include "vec3.h"
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace gmath
+{
+	// spreads the low 32 bits of v apart so that there is one zero bit between each
+	inline uint64_t part1by1(uint64_t v)
+	{
+		v &= 0xffffffff;
+		v = (v | v << 16) & 0x0000ffff0000ffffull;
+		v = (v | v << 8)  & 0x00ff00ff00ff00ffull;
+		v = (v | v << 4)  & 0x0f0f0f0f0f0f0f0full;
+		v = (v | v << 2)  & 0x3333333333333333ull;
+		v = (v | v << 1)  & 0x5555555555555555ull;
+		return v;
+	}
+
+	// spreads the low 21 bits of v apart so that there are two zero bits between each
+	inline uint64_t part1by2(uint64_t v)
+	{
+		v &= 0x1fffff;
+		v = (v | v << 32) & 0x001f00000000ffffull;
+		v = (v | v << 16) & 0x001f0000ff0000ffull;
+		v = (v | v << 8)  & 0x100f00f00f00f00full;
+		v = (v | v << 4)  & 0x10c30c30c30c30c3ull;
+		v = (v | v << 2)  & 0x1249249249249249ull;
+		return v;
+	}
+
+	// returns 2D morton (z-order) code of integer coordinates x, y
+	inline uint64_t morton2(uint x, uint y)
+	{
+#if defined(__BMI2__)
+		return _pdep_u64(x, 0x5555555555555555ull) | _pdep_u64(y, 0xaaaaaaaaaaaaaaaaull);
+#else
+		return part1by1(x) | part1by1(y) << 1;
+#endif
+	}
+
+	// returns 3D morton (z-order) code of integer coordinates x, y, z, each at most 21 bits
+	inline uint64_t morton3(uint x, uint y, uint z)
+	{
+#if defined(__BMI2__)
+		return _pdep_u64(x & 0x1fffff, 0x1249249249249249ull)
+		     | _pdep_u64(y & 0x1fffff, 0x2492492492492492ull)
+		     | _pdep_u64(z & 0x1fffff, 0x4924924924924924ull);
+#else
+		return part1by2(x) | part1by2(y) << 1 | part1by2(z) << 2;
+#endif
+	}
+
+	// transforms N coordinates of given bits in place into the transposed hilbert index
+	// (J. Skilling, "Programming the Hilbert curve", 2004)
+	template <uint N> void hilbertTranspose(uint* X, uint bits)
+	{
+		const uint M = 1u << (bits - 1);
+		for (uint Q = M; Q > 1; Q >>= 1)
+		{
+			const uint P = Q - 1;
+			for (uint i = 0; i < N; ++i)
+				if (X[i] & Q) X[0] ^= P;
+				else
+				{
+					const uint t = (X[0] ^ X[i]) & P;
+					X[0] ^= t, X[i] ^= t;
+				}
+		}
+		// gray encode
+		for (uint i = 1; i < N; ++i) X[i] ^= X[i-1];
+		uint t = 0;
+		for (uint Q = M; Q > 1; Q >>= 1)
+			if (X[N-1] & Q) t ^= Q - 1;
+		for (uint i = 0; i < N; ++i) X[i] ^= t;
+	}
+
+	// returns 2D hilbert code of integer coordinates x, y of given bits, at most 32
+	inline uint64_t hilbert2(uint x, uint y, uint bits)
+	{
+		assert(bits && bits <= 32);
+		uint X[2] { x, y };
+		hilbertTranspose<2>(X, bits);
+		return morton2(X[1], X[0]);
+	}
+
+	// returns 3D hilbert code of integer coordinates x, y, z of given bits, at most 21
+	inline uint64_t hilbert3(uint x, uint y, uint z, uint bits)
+	{
+		assert(bits && bits <= 21);
+		uint X[3] { x, y, z };
+		hilbertTranspose<3>(X, bits);
+		return morton3(X[2], X[1], X[0]);
+	}
+
+	// maps val in [lo, hi] to an integer in [0, 2^bits - 1]
+	inline uint quantize(float val, float lo, float hi, uint bits)
+	{
+		assert(bits && bits <= 32);
+		if (!(hi > lo)) return 0;
+		const double t = (double(val) - lo) / (double(hi) - lo);
+		const double top = double((uint64_t(1) << bits) - 1);
+		return t <= 0. ? 0 : t >= 1. ? uint(top) : uint(t*top + 0.5);
+	}
+
+	// computes the bounding box lo, hi of n points
+	template <uint ROWS>
+	void bounds(const base::Vec<ROWS>* pts, uint n, base::Vec<ROWS>& lo, base::Vec<ROWS>& hi)
+	{
+		assert(n);
+		lo = pts[0], hi = pts[0];
+		for (uint i = n; i--;)
+			for (uint a = ROWS; a--;)
+			{
+				lo[a] = pts[i][a]<lo[a] ? pts[i][a] : lo[a];
+				hi[a] = pts[i][a]>hi[a] ? pts[i][a] : hi[a];
+			}
+	}
+
+	// curve keys of points quantized to the bounding box lo, hi
+	inline uint64_t morton(const Vec2& p, const Vec2& lo, const Vec2& hi)
+	{
+		return morton2(quantize(p.x, lo.x, hi.x, 32), quantize(p.y, lo.y, hi.y, 32));
+	}
+	inline uint64_t morton(const Vec3& p, const Vec3& lo, const Vec3& hi)
+	{
+		return morton3(quantize(p.x, lo.x, hi.x, 21), quantize(p.y, lo.y, hi.y, 21), quantize(p.z, lo.z, hi.z, 21));
+	}
+	inline uint64_t hilbert(const Vec2& p, const Vec2& lo, const Vec2& hi)
+	{
+		return hilbert2(quantize(p.x, lo.x, hi.x, 32), quantize(p.y, lo.y, hi.y, 32), 32);
+	}
+	inline uint64_t hilbert(const Vec3& p, const Vec3& lo, const Vec3& hi)
+	{
+		return hilbert3(quantize(p.x, lo.x, hi.x, 21), quantize(p.y, lo.y, hi.y, 21), quantize(p.z, lo.z, hi.z, 21), 21);
+	}
+
+	// returns permutation perm such that keys[perm[0..n)] is ascending. LSD radix sort on 11-bit digits
+	// that moves each key together with its index, so every pass reads its input in order. histograms
+	// of all digits are taken in one pass, and digits that are equal in every key are skipped.
+	inline void sortKeys(const uint64_t* keys, uint n, uint* perm)
+	{
+		struct Entry { uint64_t key; uint idx; };
+		constexpr uint BITS { 11 }, RADIX { 1u << BITS }, PASSES { (64 + BITS - 1)/BITS };
+		if (!n) return;
+		std::vector<uint> count(PASSES*RADIX, 0);
+		for (uint i = 0; i < n; ++i)
+			for (uint d = 0; d < PASSES; ++d) ++count[d*RADIX + (keys[i] >> BITS*d & (RADIX - 1))];
+
+		// left uninitialized, every entry is written before it is read
+		std::unique_ptr<Entry[]> buf(new Entry[2*size_t(n)]);
+		Entry* src = buf.get();
+		Entry* dst = buf.get() + n;
+		for (uint i = 0; i < n; ++i) src[i].key = keys[i], src[i].idx = i;
+
+		for (uint d = 0; d < PASSES; ++d)
+		{
+			uint* offset = &count[d*RADIX];
+			if (offset[keys[0] >> BITS*d & (RADIX - 1)] == n) continue;
+
+			for (uint b = 0, sum = 0; b < RADIX; ++b)
+			{
+				const uint c = offset[b];
+				offset[b] = sum, sum += c;
+			}
+			for (uint i = 0; i < n; ++i) dst[offset[src[i].key >> BITS*d & (RADIX - 1)]++] = src[i];
+			Entry* t = src; src = dst; dst = t;
+		}
+		for (uint i = n; i--; perm[i] = src[i].idx);
+	}
+
+	// permutes n elements of data so that data[i] becomes the old data[perm[i]]
+	template <class T> void reorder(T* data, const uint* perm, uint n)
+	{
+		std::vector<T> tmp(data, data + n);
+		for (uint i = n; i--; data[i] = tmp[perm[i]]);
+	}
+
+	// rewrites count indices into an array of n elements that was reordered with perm
+	inline void remap(uint* indices, uint count, const uint* perm, uint n)
+	{
+		std::vector<uint> inv(n);
+		for (uint i = n; i--; inv[perm[i]] = i);
+		for (uint i = count; i--;)
+		{
+			assert(indices[i] < n);
+			indices[i] = inv[indices[i]];
+		}
+	}
+} // namespace gmath
+#endif
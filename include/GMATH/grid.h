@@ -0,0 +1,379 @@
+// gmath grid.h
+// Date: 19 10 2026
+// Author: arinaivanova
+// URL: https://github.com/arinaivanova/gmath
+// Commentary: Uniform grid for radius and k-nearest neighbor queries over Vec3 points.
+
+#ifndef GMATH_GRID_H_
+#define GMATH_GRID_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "curve.h"
+
+namespace gmath
+{
+	// Points are bucketed by the low bits of the morton code of their cell, so that neighboring cells
+	// land in neighboring buckets, and sorted into buckets with a counting sort. The code interleaves only
+	// as many bits of each axis as the grid needs along it, so flat and line-like point sets, which have
+	// a single cell along some axes, still spread over all buckets. The grid keeps its own sorted copy of
+	// the positions; queries report indices into the array passed to build().
+	struct Grid
+	{
+		static constexpr uint MAX_DIM { 1u << 21 };
+		// the cell size is doubled until the grid has at most this many cells per point
+		static constexpr uint MAX_CELLS_PER_POINT { 8 };
+		// buckets are sorted in this many ranges, one at a time per thread
+		static constexpr uint PARTS { 256 };
+
+		Grid(float cellSize) : size_{ cellSize }, cell_{ cellSize }, inv_{ 1.f/cellSize }, dims_{}, axes_{ 0, 1, 2 }, bits_{}, mask_{}
+		{
+			assert(cellSize>0.f);
+		}
+
+		uint size() const { return points_.size(); }
+		// cell size of the last build, at least the size passed to the constructor
+		float cellSize() const { return cell_; }
+
+		// rebuilds the grid from n points. O(n), reuses storage between calls. both passes of the sort are
+		// split over the given number of threads, 0 for one per hardware thread.
+		// returns false and leaves the grid empty if a position is not finite.
+		bool build(const Vec3* pts, uint n, uint threads = 1)
+		{
+			if (!n) { clear(); return true; }
+			points_.resize(n), index_.resize(n), cells_.resize(n), keys_.resize(n);
+
+			if (!threads) threads = std::thread::hardware_concurrency();
+			// below this many points per thread, thread startup costs more than it saves
+			const uint most = n/4096 + 1;
+			threads = !threads ? 1 : threads > most ? most : threads;
+			const uint chunk = (n + threads - 1)/threads;
+
+			std::vector<Vec3> lo(threads), hi(threads);
+			parallel(threads, [&](uint t)
+			{
+				const uint i0 = t*chunk < n ? t*chunk : n, i1 = i0 + chunk < n ? i0 + chunk : n;
+				if (i0 < i1) bounds(pts + i0, i1 - i0, lo[t], hi[t]);
+				else lo[t] = hi[t] = pts[0];
+			});
+			for (uint t = 1; t < threads; ++t)
+				for (uint a = 3; a--;)
+				{
+					lo[0][a] = lo[t][a]<lo[0][a] ? lo[t][a] : lo[0][a];
+					hi[0][a] = hi[t][a]>hi[0][a] ? hi[t][a] : hi[0][a];
+				}
+			// an infinity anywhere, or a nan in pts[0], shows in the bounds. other nans are caught with the keys.
+			for (uint a = 3; a--;)
+				if (!std::isfinite(lo[0][a]) || !std::isfinite(hi[0][a])) { clear(); return false; }
+			origin_ = lo[0];
+			cell_ = size_;
+			for (uint doubled = 0; doubled < 256 && !fit(lo[0], hi[0], n); ++doubled) cell_ *= 2.f;
+			inv_ = 1.f/cell_;
+			orderAxes();
+
+			uint buckets = 1;
+			while (buckets < n) buckets <<= 1;
+			mask_ = buckets - 1;
+			const uint parts = buckets < PARTS ? buckets : PARTS;
+			uint shift = 0;
+			while (buckets >> shift > parts) ++shift;
+
+			// first pass: partition the points by the top bits of their bucket, so that each partition owns
+			// a contiguous range of buckets. counts_ holds a histogram of partitions per thread, which is
+			// turned into the offset each thread scatters its points of a partition to.
+			counts_.assign(size_t(threads)*parts, 0);
+			std::vector<char> finite(threads, 1);
+			parallel(threads, [&](uint t)
+			{
+				uint* count = &counts_[size_t(t)*parts];
+				const uint i1 = t*chunk + chunk < n ? t*chunk + chunk : n;
+				bool ok = true;
+				for (uint i = t*chunk; i < i1; ++i)
+				{
+					const float sum = pts[i].x + pts[i].y + pts[i].z;
+					ok &= sum - sum == 0.f;
+					keys_[i] = key(pts[i]);
+					++count[(keys_[i] & mask_) >> shift];
+				}
+				finite[t] = ok;
+			});
+			for (uint t = threads; t--;)
+				if (!finite[t]) { clear(); return false; }
+
+			// exclusive scan in partition-major, thread-minor order, keeping the first entry of each partition
+			std::vector<uint> first(parts + 1);
+			for (uint q = 0, sum = 0; q < parts; ++q)
+			{
+				first[q] = sum;
+				for (uint t = 0; t < threads; ++t)
+				{
+					uint& count = counts_[size_t(t)*parts + q];
+					const uint c = count;
+					count = sum, sum += c;
+				}
+			}
+			first[parts] = n;
+
+			scratch_.resize(n);
+			parallel(threads, [&](uint t)
+			{
+				uint* offset = &counts_[size_t(t)*parts];
+				const uint i1 = t*chunk + chunk < n ? t*chunk + chunk : n;
+				for (uint i = t*chunk; i < i1; ++i)
+					scratch_[offset[(keys_[i] & mask_) >> shift]++] = { keys_[i], pts[i], i };
+			});
+
+			// second pass: counting sort of each partition by bucket, in its own slice of start_. the slice
+			// is scanned to the end of each bucket, and entries are placed back to front so the order within
+			// a bucket stays the input order and start_[b] ends up at the first entry of bucket b.
+			start_.resize(buckets + 1);
+			start_[buckets] = n;
+			std::atomic<uint> next { 0 };
+			parallel(threads, [&](uint)
+			{
+				for (uint q; (q = next++) < parts;)
+				{
+					uint* start = &start_[size_t(q) << shift];
+					const uint width = 1u << shift;
+					std::fill(start, start + width, 0u);
+					for (uint j = first[q]; j < first[q+1]; ++j) ++start[scratch_[j].cell & (width - 1)];
+					for (uint b = 0, sum = first[q]; b < width; ++b) sum += start[b], start[b] = sum;
+					for (uint j = first[q+1]; j-- > first[q];)
+					{
+						const Entry& e = scratch_[j];
+						const uint k = --start[e.cell & (width - 1)];
+						points_[k] = e.point;
+						index_[k] = e.index;
+						cells_[k] = e.cell;
+					}
+				}
+			});
+			return true;
+		}
+
+		// calls f(index, squared distance) for every point within distance r of p
+		template <class F> void radius(const Vec3& p, float r, F f) const
+		{
+			if (points_.empty()) return;
+			const float r2 = r*r;
+			const uint x1 = coord(p.x + r, 0), y1 = coord(p.y + r, 1), z1 = coord(p.z + r, 2);
+			for (uint z = coord(p.z - r, 2); z <= z1; ++z)
+				for (uint y = coord(p.y - r, 1); y <= y1; ++y)
+					for (uint x = coord(p.x - r, 0); x <= x1; ++x)
+						visit(code(x, y, z), p, r2, f);
+		}
+
+		// finds up to k points nearest to p, searching outward ring by ring from the cell of p.
+		// writes their indices and squared distances to idx and dist2 in ascending order of distance.
+		// returns the number of points found.
+		uint nearest(const Vec3& p, uint k, uint* idx, float* dist2) const
+		{
+			uint found = 0;
+			if (!k || points_.empty()) return 0;
+
+			auto insert = [&](uint i, float d2)
+			{
+				if (found < k)
+				{
+					idx[found] = i, dist2[found] = d2;
+					siftUp(idx, dist2, found++);
+				}
+				else if (d2 < dist2[0])
+				{
+					idx[0] = i, dist2[0] = d2;
+					siftDown(idx, dist2, 0, found);
+				}
+			};
+
+			// sparse grids can have many empty cells around p: once the rings have cost more than
+			// looking at every point, look at every point instead
+			if (!rings(p, k, found, dist2, insert))
+			{
+				found = 0;
+				for (uint j = points_.size(); j--;)
+				{
+					const Vec3 d = points_[j] - p;
+					insert(index_[j], dot(d, d));
+				}
+			}
+
+			// heap sort the max-heap into ascending order
+			for (uint m = found; m > 1;)
+			{
+				--m;
+				const uint ti = idx[0]; idx[0] = idx[m]; idx[m] = ti;
+				const float td = dist2[0]; dist2[0] = dist2[m]; dist2[m] = td;
+				siftDown(idx, dist2, 0, m);
+			}
+			return found;
+		}
+
+	private:
+		void clear()
+		{
+			points_.clear(), index_.clear(), cells_.clear();
+			start_.assign(2, 0);
+			mask_ = 0;
+		}
+
+		// calls f(t) for t in [0, threads), on threads-1 new threads and the calling thread
+		template <class F> static void parallel(uint threads, F f)
+		{
+			std::vector<std::thread> pool;
+			pool.reserve(threads - 1);
+			for (uint t = 1; t < threads; ++t) pool.emplace_back(f, t);
+			f(0);
+			for (std::thread& thread : pool) thread.join();
+		}
+
+		// sets dims_ for the bounding box lo, hi and cell_. false if that is too many cells for n points.
+		bool fit(const Vec3& lo, const Vec3& hi, uint n)
+		{
+			double cells = 1.;
+			for (uint a = 3; a--;)
+			{
+				const double d = (double(hi[a]) - lo[a])/cell_ + 1.;
+				dims_[a] = d<MAX_DIM ? uint(d) : MAX_DIM;
+				cells *= dims_[a];
+			}
+			return cells <= double(n)*MAX_CELLS_PER_POINT;
+		}
+
+		// visits the rings of cells around the cell of p until the k-th best point found is closer than
+		// the next ring. false if more cells were looked at than there are points.
+		template <class F> bool rings(const Vec3& p, uint k, const uint& found, const float* dist2, F& insert) const
+		{
+			const int c[3] { int(coord(p.x, 0)), int(coord(p.y, 1)), int(coord(p.z, 2)) };
+			const int dims[3] { int(dims_[0]), int(dims_[1]), int(dims_[2]) };
+			int last = 0;
+			for (uint a = 3; a--;)
+			{
+				const int far = c[a] > dims[a] - 1 - c[a] ? c[a] : dims[a] - 1 - c[a];
+				last = far > last ? far : last;
+			}
+
+			size_t work = 0;
+			const size_t budget = points_.size() + 64;
+			for (int d = 0; d <= last; ++d)
+			{
+				// points in ring d are at least (d-1) cells away from p
+				const float reach = (d - 1)*cell_;
+				if (found == k && d > 1 && dist2[0] <= reach*reach) return true;
+
+				const int x0 = c[0] - d > 0 ? c[0] - d : 0, x1 = c[0] + d < dims[0] ? c[0] + d : dims[0] - 1;
+				const int y0 = c[1] - d > 0 ? c[1] - d : 0, y1 = c[1] + d < dims[1] ? c[1] + d : dims[1] - 1;
+				const int z0 = c[2] - d > 0 ? c[2] - d : 0, z1 = c[2] + d < dims[2] ? c[2] + d : dims[2] - 1;
+				for (int z = z0; z <= z1; ++z)
+					for (int y = y0; y <= y1; ++y)
+					{
+						const float r2 = found == k ? dist2[0] : INFINITY;
+						// only the shell of the ring: interior rows contribute their two end cells
+						if (z == c[2] - d || z == c[2] + d || y == c[1] - d || y == c[1] + d)
+						{
+							for (int x = x0; x <= x1; ++x) visit(code(x, y, z), p, r2, insert);
+							work += x1 - x0 + 1;
+						}
+						else
+						{
+							if (c[0] - d >= 0)      visit(code(c[0] - d, y, z), p, r2, insert);
+							if (c[0] + d < dims[0]) visit(code(c[0] + d, y, z), p, r2, insert);
+							work += 2;
+						}
+						if (work > budget) return false;
+					}
+			}
+			return true;
+		}
+
+		uint coord(float v, uint a) const
+		{
+			const float c = (v - origin_[a])*inv_;
+			// nan goes to cell 0
+			return !(c > 0.f) ? 0 : c >= dims_[a] - 1 ? dims_[a] - 1 : uint(c);
+		}
+
+		uint64_t key(const Vec3& p) const { return code(coord(p.x, 0), coord(p.y, 1), coord(p.z, 2)); }
+
+		// orders the axes by the bits of their cell coordinates, ties by axis
+		void orderAxes()
+		{
+			uint bits[3];
+			for (uint a = 3; a--;)
+				for (bits[a] = 0; dims_[a] > 1u << bits[a]; ++bits[a]);
+			uint* s = axes_;
+			s[0] = 0, s[1] = 1, s[2] = 2;
+			if (bits[s[1]] < bits[s[0]]) std::swap(s[0], s[1]);
+			if (bits[s[2]] < bits[s[1]]) std::swap(s[1], s[2]);
+			if (bits[s[1]] < bits[s[0]]) std::swap(s[0], s[1]);
+			bits_[0] = bits[s[0]], bits_[1] = bits[s[1]];
+		}
+
+		// morton code of a cell over the bits of each axis: levels where all three axes have bits are
+		// interleaved three ways, then two ways while two axes have bits left, then the last axis alone
+		uint64_t code(uint x, uint y, uint z) const
+		{
+			const uint c[3] { x, y, z };
+			const uint b0 = bits_[0], b1 = bits_[1];
+			const uint m0 = (1u << b0) - 1, m1 = (1u << b1) - 1;
+			const uint s1 = axes_[1], s2 = axes_[2];
+			const uint lo = s1 < s2 ? s1 : s2, hi = s1 < s2 ? s2 : s1;
+
+			uint64_t out = morton3(x & m0, y & m0, z & m0);
+			out |= morton2((c[lo] & m1) >> b0, (c[hi] & m1) >> b0) << 3*b0;
+			out |= uint64_t(c[s2] >> b1) << (3*b0 + 2*(b1 - b0));
+			return out;
+		}
+
+		template <class F> void visit(uint64_t cell, const Vec3& p, float r2, F& f) const
+		{
+			const uint b = cell & mask_;
+			for (uint j = start_[b]; j < start_[b+1]; ++j)
+			{
+				// buckets are shared by cells with equal low code bits
+				if (cells_[j] != cell) continue;
+				const Vec3 d = points_[j] - p;
+				const float d2 = dot(d, d);
+				if (d2 <= r2) f(index_[j], d2);
+			}
+		}
+
+		static void siftUp(uint* idx, float* dist2, uint i)
+		{
+			for (uint parent; i && dist2[parent = (i-1)/2] < dist2[i]; i = parent)
+			{
+				const uint ti = idx[i]; idx[i] = idx[parent]; idx[parent] = ti;
+				const float td = dist2[i]; dist2[i] = dist2[parent]; dist2[parent] = td;
+			}
+		}
+
+		static void siftDown(uint* idx, float* dist2, uint i, uint n)
+		{
+			for (uint child; (child = 2*i + 1) < n; i = child)
+			{
+				if (child + 1 < n && dist2[child+1] > dist2[child]) ++child;
+				if (dist2[child] <= dist2[i]) break;
+				const uint ti = idx[i]; idx[i] = idx[child]; idx[child] = ti;
+				const float td = dist2[i]; dist2[i] = dist2[child]; dist2[child] = td;
+			}
+		}
+
+		float size_, cell_, inv_;
+		Vec3 origin_;
+		uint dims_[3];
+		uint axes_[3];                // axes by ascending bits of their cell coordinates
+		uint bits_[2];                // bits along axes_[0] and axes_[1]
+		uint mask_;
+		std::vector<uint> start_;     // bucket b holds sorted entries [start_[b], start_[b+1])
+		std::vector<Vec3> points_;    // positions in bucket order
+		std::vector<uint> index_;     // original index of each sorted entry
+		std::vector<uint64_t> cells_; // morton code of the cell of each sorted entry
+		std::vector<uint64_t> keys_;  // build scratch, morton code of each input point
+		std::vector<uint> counts_;    // build scratch, partition histogram per thread
+		struct Entry { uint64_t cell; Vec3 point; uint index; };
+		std::vector<Entry> scratch_;  // build scratch, points in partition order
+	};
+} // namespace gmath
+#endif
@@ -26,6 +26,8 @@ namespace gmath
    		Quat operator + (float val)     const { return {w+val, x+val, y+val, z+val}; }
 		Quat operator - (const Quat& q) const { return {w-q.w, x-q.x, y-q.y, z-q.z}; }
 		Quat operator - (float val)     const { return {w-val, x-val, y-val, z-val}; }
+		Quat operator * (float val)     const { return {w*val, x*val, y*val, z*val}; }
+		Quat operator - ()              const { return {-w, -x, -y, -z}; }
 		
 		Quat operator * (const Vec3& v) const
 		{
@@ -49,5 +51,31 @@ namespace gmath
 				};
 		}
 	};
+
+	inline float dot(const Quat& lhs, const Quat& rhs) { return lhs.w*rhs.w + lhs.x*rhs.x + lhs.y*rhs.y + lhs.z*rhs.z; }
+
+	inline Quat normalize(const Quat& q)
+	{
+		const float m = sqrtf(dot(q, q));
+		return m ? q * (1.f/m) : Quat{};
+	}
+
+	// normalized linear interpolation between rotations q0 and q1 with weight t, along the shorter arc
+	inline Quat nlerp(const Quat& q0, const Quat& q1, float t)
+	{
+		const float t1 = dot(q0, q1) < 0.f ? -t : t;
+		return normalize(q0*(1.f - t) + q1*t1);
+	}
+
+	// spherical linear interpolation between rotations q0 and q1 with weight t, along the shorter arc
+	inline Quat slerp(const Quat& q0, const Quat& q1, float t)
+	{
+		float c = dot(q0, q1);
+		const Quat q = c < 0.f ? (c = -c, -q1) : q1;
+		// nearly parallel: sin(theta) vanishes, fall back to nlerp
+		if (c > 0.9995f) return normalize(q0*(1.f - t) + q*t);
+		const float theta = acosf(c), s = 1.f/sinf(theta);
+		return q0*(sinf((1.f - t)*theta)*s) + q*(sinf(t*theta)*s);
+	}
 }
 #endif
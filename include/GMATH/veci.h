@@ -0,0 +1,203 @@
+// gmath veci.h
+// Date: 19 10 2026
+// Author: arinaivanova
+// URL: https://github.com/arinaivanova/gmath
+// Commentary: Integer and fixed-point vectors with exact products, for rasterization.
+
+#ifndef GMATH_VECI_H_
+#define GMATH_VECI_H_
+
+#include <stdint.h>
+#include "vec3.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace gmath
+{
+	namespace base
+	{
+		template <class T> struct IVec2
+		{
+			T x, y;
+
+			IVec2()         : x{}, y{} {}
+			IVec2(T X, T Y) : x{ X }, y{ Y } {}
+
+			      T& operator [] (uint i)       { assert(i < 2); return (&x)[i]; }
+			const T& operator [] (uint i) const { assert(i < 2); return (&x)[i]; }
+
+			IVec2 operator - () const { return {-x, -y}; }
+
+			IVec2 operator + (const IVec2& v) const { return { x + v.x, y + v.y }; }
+			IVec2 operator - (const IVec2& v) const { return { x - v.x, y - v.y }; }
+			IVec2 operator * (T val)          const { return { x * val, y * val }; }
+
+			IVec2& operator += (const IVec2& v) { x += v.x, y += v.y; return *this; }
+			IVec2& operator -= (const IVec2& v) { x -= v.x, y -= v.y; return *this; }
+			IVec2& operator *= (T val)          { x *= val, y *= val; return *this; }
+
+			bool operator == (const IVec2& v) const { return x == v.x && y == v.y; }
+			bool operator != (const IVec2& v) const { return !(*this == v); }
+		};
+
+		template <class T> struct IVec3
+		{
+			T x, y, z;
+
+			IVec3()              : x{}, y{}, z{} {}
+			IVec3(T X, T Y, T Z) : x{ X }, y{ Y }, z{ Z } {}
+
+			      T& operator [] (uint i)       { assert(i < 3); return (&x)[i]; }
+			const T& operator [] (uint i) const { assert(i < 3); return (&x)[i]; }
+
+			IVec3 operator - () const { return {-x, -y, -z}; }
+
+			IVec3 operator + (const IVec3& v) const { return { x + v.x, y + v.y, z + v.z }; }
+			IVec3 operator - (const IVec3& v) const { return { x - v.x, y - v.y, z - v.z }; }
+			IVec3 operator * (T val)          const { return { x * val, y * val, z * val }; }
+
+			IVec3& operator += (const IVec3& v) { x += v.x, y += v.y, z += v.z; return *this; }
+			IVec3& operator -= (const IVec3& v) { x -= v.x, y -= v.y, z -= v.z; return *this; }
+			IVec3& operator *= (T val)          { x *= val, y *= val, z *= val; return *this; }
+
+			bool operator == (const IVec3& v) const { return x == v.x && y == v.y && z == v.z; }
+			bool operator != (const IVec3& v) const { return !(*this == v); }
+
+			IVec2<T> xy() const { return { x, y }; }
+		};
+	} // namespace base
+
+	typedef base::IVec2<int32_t> Vec2i;
+	typedef base::IVec3<int32_t> Vec3i;
+	typedef base::IVec3<int64_t> Vec3l;
+
+	// 2D vector with FRAC fractional bits, e.g. 28.4 for subpixel precise rasterization.
+	// products of two Fixed2 have 2*FRAC fractional bits.
+	template <uint FRAC> struct Fixed2 : Vec2i
+	{
+		static constexpr int32_t ONE { 1 << FRAC };
+
+		Fixed2() {}
+		Fixed2(const Vec2i& v) : Vec2i{ v } {}
+		// rounds to the nearest 1/ONE
+		explicit Fixed2(const Vec2& v) : Vec2i{ int32_t(lrintf(v.x*ONE)), int32_t(lrintf(v.y*ONE)) } {}
+
+		Vec2 vec2() const { return { x * (1.f/ONE), y * (1.f/ONE) }; }
+	};
+	typedef Fixed2<4> Fix2;
+
+	// products are taken in 64 bits and are exact
+	inline int64_t dot(const Vec2i& lhs, const Vec2i& rhs) { return int64_t(lhs.x)*rhs.x + int64_t(lhs.y)*rhs.y; }
+
+	inline int64_t dot(const Vec3i& lhs, const Vec3i& rhs)
+	{
+		return int64_t(lhs.x)*rhs.x + int64_t(lhs.y)*rhs.y + int64_t(lhs.z)*rhs.z;
+	}
+
+	inline Vec3l cross(const Vec3i& lhs, const Vec3i& rhs)
+	{
+		return {int64_t(lhs.y)*rhs.z - int64_t(rhs.y)*lhs.z,
+		        int64_t(lhs.z)*rhs.x - int64_t(rhs.z)*lhs.x,
+		        int64_t(lhs.x)*rhs.y - int64_t(rhs.x)*lhs.y};
+	}
+
+	// exact edge function, see edge(const Vec2&, const Vec2&, const Vec2&).
+	// the result is exact for coordinates below 2^30 in magnitude.
+	inline int64_t edge(const Vec2i& v0, const Vec2i& v1, const Vec2i& v2)
+	{
+		return int64_t(v2.x)*(v0.y - v1.y) + int64_t(v2.y)*(v1.x - v0.x) + int64_t(v0.x)*v1.y - int64_t(v0.y)*v1.x;
+	}
+
+	// evaluates edge(v0, v1, p) at the 8 points p, p+(step,0), ..., p+(7*step,0) of a row into out.
+	// the edge function is affine in p, so each lane is the first plus a multiple of the x increment.
+	inline void edgeRow8(const Vec2i& v0, const Vec2i& v1, const Vec2i& p, int32_t step, int64_t* out)
+	{
+		const int64_t e = edge(v0, v1, p);
+		const int64_t dx = int64_t(v0.y - v1.y)*step;
+#if defined(__AVX2__)
+		const __m256i d = _mm256_set1_epi64x(dx);
+		const __m256i lo = _mm256_add_epi64(_mm256_set1_epi64x(e), _mm256_set_epi64x(3*dx, 2*dx, dx, 0));
+		const __m256i hi = _mm256_add_epi64(lo, _mm256_slli_epi64(d, 2));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lo);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4), hi);
+#else
+		for (uint i = 0; i < 8; ++i) out[i] = e + dx*i;
+#endif
+	}
+
+#if defined(__AVX2__)
+	namespace base
+	{
+		// sign extends 4 int32 into 64-bit lanes, whose low halves _mm256_mul_epi32 multiplies exactly
+		inline __m256i load4(const int32_t* p) { return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+		inline void store4(int64_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+		inline __m256i mul4(__m256i a, __m256i b) { return _mm256_mul_epi32(a, b); }
+	} // namespace base
+#endif
+
+	// batches of 8 vectors laid out per component, e.g. a[1][i] is y of vector i. the results equal those
+	// of dot, cross and edge on each vector. with AVX2 each batch is two halves of 4 64-bit lanes.
+	template <uint N> void dot8(const int32_t (&a)[N][8], const int32_t (&b)[N][8], int64_t* out)
+	{
+#if defined(__AVX2__)
+		for (uint h = 0; h < 8; h += 4)
+		{
+			__m256i sum = base::mul4(base::load4(a[0] + h), base::load4(b[0] + h));
+			for (uint c = 1; c < N; ++c) sum = _mm256_add_epi64(sum, base::mul4(base::load4(a[c] + h), base::load4(b[c] + h)));
+			base::store4(out + h, sum);
+		}
+#else
+		for (uint i = 0; i < 8; ++i)
+		{
+			int64_t sum = int64_t(a[0][i])*b[0][i];
+			for (uint c = 1; c < N; ++c) sum += int64_t(a[c][i])*b[c][i];
+			out[i] = sum;
+		}
+#endif
+	}
+
+	inline void cross8(const int32_t (&a)[3][8], const int32_t (&b)[3][8], int64_t (&out)[3][8])
+	{
+#if defined(__AVX2__)
+		for (uint h = 0; h < 8; h += 4)
+		{
+			__m256i a4[3], b4[3];
+			for (uint c = 3; c--;) a4[c] = base::load4(a[c] + h), b4[c] = base::load4(b[c] + h);
+			for (uint c = 3; c--;)
+			{
+				const uint c1 = (c + 1) % 3, c2 = (c + 2) % 3;
+				base::store4(out[c] + h, _mm256_sub_epi64(base::mul4(a4[c1], b4[c2]), base::mul4(b4[c1], a4[c2])));
+			}
+		}
+#else
+		for (uint i = 0; i < 8; ++i)
+			for (uint c = 3; c--;)
+			{
+				const uint c1 = (c + 1) % 3, c2 = (c + 2) % 3;
+				out[c][i] = int64_t(a[c1][i])*b[c2][i] - int64_t(b[c1][i])*a[c2][i];
+			}
+#endif
+	}
+
+	// edge(v0[i], v1[i], p[i]) for 8 independent edges and points
+	inline void edge8(const int32_t (&v0)[2][8], const int32_t (&v1)[2][8], const int32_t (&p)[2][8], int64_t* out)
+	{
+#if defined(__AVX2__)
+		for (uint h = 0; h < 8; h += 4)
+		{
+			const __m256i x0 = base::load4(v0[0] + h), y0 = base::load4(v0[1] + h);
+			const __m256i x1 = base::load4(v1[0] + h), y1 = base::load4(v1[1] + h);
+			// differences of coordinates below 2^30 fit the 32 bits _mm256_mul_epi32 reads
+			__m256i e = base::mul4(base::load4(p[0] + h), _mm256_sub_epi64(y0, y1));
+			e = _mm256_add_epi64(e, base::mul4(base::load4(p[1] + h), _mm256_sub_epi64(x1, x0)));
+			e = _mm256_add_epi64(e, _mm256_sub_epi64(base::mul4(x0, y1), base::mul4(y0, x1)));
+			base::store4(out + h, e);
+		}
+#else
+		for (uint i = 0; i < 8; ++i)
+			out[i] = edge(Vec2i{ v0[0][i], v0[1][i] }, Vec2i{ v1[0][i], v1[1][i] }, Vec2i{ p[0][i], p[1][i] });
+#endif
+	}
+} // namespace gmath
+#endif